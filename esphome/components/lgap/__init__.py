@@ -3,9 +3,12 @@ import esphome.config_validation as cv
 from esphome.cpp_helpers import gpio_pin_expression
 from esphome.components import uart
 from esphome.const import (
+    CONF_ADDRESS,
     CONF_ID,
+    CONF_TRIGGER_ID,
+    CONF_UART_ID,
 )
-from esphome import pins
+from esphome import automation, pins
 
 DEPENDENCIES = ["uart"]
 CODEOWNERS = ["@jourdant"]
@@ -14,23 +17,62 @@ MULTI_CONF = True
 #class metadata
 lgap_ns = cg.esphome_ns.namespace("lgap")
 LGAP = lgap_ns.class_("LGAP", uart.UARTDevice, cg.Component)
+LGAPDevice = lgap_ns.class_("LGAPDevice", cg.Component)
+LGAPModbusServer = lgap_ns.class_("LGAPModbusServer", uart.UARTDevice, cg.Component)
+GroupControlCompleteTrigger = lgap_ns.class_(
+    "GroupControlCompleteTrigger", automation.Trigger.template(cg.uint32, cg.uint16, cg.uint16, cg.std_vector.template(cg.uint8))
+)
 
 #setting names
 CONF_LGAP_ID = "lgap_id"
 CONF_RECEIVE_WAIT_TIME = "receive_wait_time"
 CONF_LOOP_WAIT_TIME = "loop_wait_time"
 CONF_FLOW_CONTROL_PIN = "flow_control_pin"
+CONF_TRACE_BUFFER_SIZE = "trace_buffer_size"
+CONF_ON_GROUP_CONTROL_COMPLETE = "on_group_control_complete"
+CONF_MODBUS_SERVER = "modbus_server"
+CONF_PASSIVE = "passive"
 
-#build schema
-CONFIG_SCHEMA = uart.UART_DEVICE_SCHEMA.extend(
+
+def validate_power_of_two(value):
+    value = cv.int_range(min=16, max=4096)(value)
+    if value & (value - 1) != 0:
+        raise cv.Invalid("Must be a power of two")
+    return value
+
+
+#modbus server runs on its own uart, so uart_id is required to stop it defaulting to the lgap uart
+MODBUS_SERVER_SCHEMA = cv.Schema(
     {
-        cv.GenerateID(): cv.declare_id(LGAP),
+        cv.GenerateID(): cv.declare_id(LGAPModbusServer),
+        cv.Required(CONF_UART_ID): cv.use_id(uart.UARTComponent),
+        cv.Optional(CONF_ADDRESS, default=1): cv.int_range(min=1, max=247),
         cv.Optional(CONF_FLOW_CONTROL_PIN): pins.gpio_output_pin_schema,
-        cv.Optional(CONF_RECEIVE_WAIT_TIME, default="500ms"): cv.positive_time_period_milliseconds,
-        cv.Optional(CONF_LOOP_WAIT_TIME, default="500ms"): cv.positive_time_period_milliseconds,
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
+#build schema
+#disable_loop()/enable_loop() are used to sleep between polls
+CONFIG_SCHEMA = cv.All(
+    uart.UART_DEVICE_SCHEMA.extend(
+        {
+            cv.GenerateID(): cv.declare_id(LGAP),
+            cv.Optional(CONF_FLOW_CONTROL_PIN): pins.gpio_output_pin_schema,
+            cv.Optional(CONF_RECEIVE_WAIT_TIME, default="500ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_LOOP_WAIT_TIME, default="500ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_PASSIVE, default=False): cv.boolean,
+            cv.Optional(CONF_TRACE_BUFFER_SIZE): validate_power_of_two,
+            cv.Optional(CONF_MODBUS_SERVER): MODBUS_SERVER_SCHEMA,
+            cv.Optional(CONF_ON_GROUP_CONTROL_COMPLETE): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(GroupControlCompleteTrigger),
+                }
+            ),
+        }
+    ).extend(cv.COMPONENT_SCHEMA),
+    cv.require_esphome_version(2025, 7, 0),
+)
+
 
 async def to_code(config):
     #register device
@@ -46,6 +88,39 @@ async def to_code(config):
         pin = await gpio_pin_expression(config[CONF_FLOW_CONTROL_PIN])
         cg.add(var.set_flow_control_pin(pin))
 
+    cg.add(var.set_passive(config[CONF_PASSIVE]))
+
     #times
     cg.add(var.set_receive_wait_time(config[CONF_RECEIVE_WAIT_TIME]))
     cg.add(var.set_loop_wait_time(config[CONF_LOOP_WAIT_TIME]))
+
+    #tracing is compiled out entirely unless a buffer size is set
+    if CONF_TRACE_BUFFER_SIZE in config:
+        cg.add_define("USE_LGAP_TRACE")
+        cg.add(var.set_trace_buffer_size(config[CONF_TRACE_BUFFER_SIZE]))
+
+    #modbus server
+    if CONF_MODBUS_SERVER in config:
+        conf = config[CONF_MODBUS_SERVER]
+        server = cg.new_Pvariable(conf[CONF_ID])
+        await cg.register_component(server, conf)
+        await uart.register_uart_device(server, conf)
+        cg.add(server.set_parent(var))
+        cg.add(server.set_address(conf[CONF_ADDRESS]))
+        if CONF_FLOW_CONTROL_PIN in conf:
+            pin = await gpio_pin_expression(conf[CONF_FLOW_CONTROL_PIN])
+            cg.add(server.set_flow_control_pin(pin))
+
+    #automations
+    for conf in config.get(CONF_ON_GROUP_CONTROL_COMPLETE, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(
+            trigger,
+            [
+                (cg.uint32, "elapsed"),
+                (cg.uint16, "succeeded"),
+                (cg.uint16, "total"),
+                (cg.std_vector.template(cg.uint8), "failed_zones"),
+            ],
+            conf,
+        )
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include <vector>
+#include "lgap.h"
+
+namespace esphome
+{
+  namespace lgap
+  {
+    class GroupControlCompleteTrigger : public Trigger<uint32_t, uint16_t, uint16_t, std::vector<uint8_t>>
+    {
+      public:
+        explicit GroupControlCompleteTrigger(LGAP *parent)
+        {
+          parent->add_on_group_write_complete_callback([this](uint32_t elapsed, uint16_t succeeded, uint16_t total, const std::vector<uint8_t> &failed_zones)
+                                                       { this->trigger(elapsed, succeeded, total, failed_zones); });
+        }
+    };
+
+  } // namespace lgap
+} // namespace esphome
@@ -1,22 +1,30 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
+from esphome import automation
 from esphome.components import climate
 from esphome.const import (
     CONF_ID,
+    CONF_MODE,
+    CONF_FAN_MODE,
+    CONF_SWING_MODE,
+    CONF_TARGET_TEMPERATURE,
 )
 from .. import (
     lgap_ns,
     LGAP,
+    LGAPDevice,
     CONF_LGAP_ID
 )
 
 DEPENDENCIES = ["lgap"]
 CODEOWNERS = ["@jourdant"]
 
-LGAP_HVAC_Climate = lgap_ns.class_("LGAPHVACClimate", cg.Component, climate.Climate)
+LGAP_HVAC_Climate = lgap_ns.class_("LGAPHVACClimate", LGAPDevice, climate.Climate)
+GroupControlAction = lgap_ns.class_("GroupControlAction", automation.Action)
 
 CONF_ZONE_NUMBER = "zone"
 CONF_TEMPERATURE_PUBISH_TIME = "temperature_publish_time"
+CONF_ZONES = "zones"
 
 CONFIG_SCHEMA = climate.CLIMATE_SCHEMA.extend(
     {
@@ -43,4 +51,39 @@ async def to_code(config):
     #set properties of the climate component
     cg.add(var.set_zone_number(config[CONF_ZONE_NUMBER]))
     cg.add(var.set_temperature_publish_time(config[CONF_TEMPERATURE_PUBISH_TIME]))
-    
+
+
+GROUP_CONTROL_ACTION_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ZONES): cv.All(cv.ensure_list(cv.use_id(LGAP_HVAC_Climate)), cv.Length(min=1)),
+        cv.Optional(CONF_MODE): cv.templatable(climate.validate_climate_mode),
+        cv.Optional(CONF_FAN_MODE): cv.templatable(climate.validate_climate_fan_mode),
+        cv.Optional(CONF_SWING_MODE): cv.templatable(climate.validate_climate_swing_mode),
+        #the request only has 4 bits for the setpoint
+        cv.Optional(CONF_TARGET_TEMPERATURE): cv.templatable(cv.All(cv.temperature, cv.Range(min=16, max=30))),
+    }
+)
+
+
+@automation.register_action("lgap.group_control", GroupControlAction, GROUP_CONTROL_ACTION_SCHEMA)
+async def group_control_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+
+    zones = []
+    for zone in config[CONF_ZONES]:
+        zones.append(await cg.get_variable(zone))
+    cg.add(var.set_zones(zones))
+
+    if CONF_MODE in config:
+        template_ = await cg.templatable(config[CONF_MODE], args, climate.ClimateMode)
+        cg.add(var.set_mode(template_))
+    if CONF_FAN_MODE in config:
+        template_ = await cg.templatable(config[CONF_FAN_MODE], args, climate.ClimateFanMode)
+        cg.add(var.set_fan_mode(template_))
+    if CONF_SWING_MODE in config:
+        template_ = await cg.templatable(config[CONF_SWING_MODE], args, climate.ClimateSwingMode)
+        cg.add(var.set_swing_mode(template_))
+    if CONF_TARGET_TEMPERATURE in config:
+        template_ = await cg.templatable(config[CONF_TARGET_TEMPERATURE], args, float)
+        cg.add(var.set_target_temperature(template_))
+    return var
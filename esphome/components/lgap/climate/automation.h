@@ -0,0 +1,67 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "esphome/core/helpers.h"
+#include "../lgap.h"
+#include "lgap_climate.h"
+#include <cmath>
+
+namespace esphome
+{
+  namespace lgap
+  {
+    // applies one desired state to many zones, then hands them to their LGAP bus as a single group write
+    template<typename... Ts> class GroupControlAction : public Action<Ts...>
+    {
+      public:
+        TEMPLATABLE_VALUE(climate::ClimateMode, mode)
+        TEMPLATABLE_VALUE(climate::ClimateFanMode, fan_mode)
+        TEMPLATABLE_VALUE(climate::ClimateSwingMode, swing_mode)
+        TEMPLATABLE_VALUE(float, target_temperature)
+
+        void set_zones(const std::vector<LGAPHVACClimate *> &zones) { this->zones_ = zones; }
+
+        void play(Ts... x) override
+        {
+          std::vector<LGAP *> buses;
+          for (auto *zone : this->zones_)
+          {
+            auto call = zone->make_call();
+            if (this->mode_.has_value())
+              call.set_mode(this->mode_.value(x...));
+            if (this->fan_mode_.has_value())
+              call.set_fan_mode(this->fan_mode_.value(x...));
+            if (this->swing_mode_.has_value())
+              call.set_swing_mode(this->swing_mode_.value(x...));
+            if (this->target_temperature_.has_value())
+            {
+              // templated setpoints aren't range checked by the schema and would wrap in the request
+              float target_temperature = this->target_temperature_.value(x...);
+              if (!std::isnan(target_temperature))
+                call.set_target_temperature(clamp(target_temperature, (float) MIN_WRITE_TEMPERATURE, (float) MAX_WRITE_TEMPERATURE));
+            }
+            call.perform();
+
+            if (std::find(buses.begin(), buses.end(), zone->get_parent()) == buses.end())
+              buses.push_back(zone->get_parent());
+          }
+
+          // zones can live on different LGAP buses, each bus gets its own sweep
+          for (auto *bus : buses)
+          {
+            std::vector<LGAPDevice *> group;
+            for (auto *zone : this->zones_)
+            {
+              if (zone->get_parent() == bus)
+                group.push_back(zone);
+            }
+            bus->queue_group_write(group);
+          }
+        }
+
+      protected:
+        std::vector<LGAPHVACClimate *> zones_{};
+    };
+
+  } // namespace lgap
+} // namespace esphome
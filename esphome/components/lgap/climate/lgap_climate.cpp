@@ -94,6 +94,13 @@ namespace esphome
     {
       ESP_LOGD(TAG, "esphome::climate::ClimateCall");
 
+      // another master owns the bus, publishing the new state would only be undone by the next response
+      if (this->parent_->is_passive())
+      {
+        ESP_LOGW(TAG, "Zone %d is in passive mode. Ignoring control request...", this->zone_number);
+        return;
+      }
+
       // mode
       if (call.get_mode().has_value())
       {
@@ -216,9 +223,69 @@ namespace esphome
       }
     }
 
+    static climate::ClimateMode lgap_mode_to_climate_mode(uint8_t mode)
+    {
+      if (mode == 1)
+        return climate::CLIMATE_MODE_DRY;
+      if (mode == 2)
+        return climate::CLIMATE_MODE_FAN_ONLY;
+      if (mode == 3)
+        return climate::CLIMATE_MODE_HEAT_COOL;
+      if (mode == 4)
+        return climate::CLIMATE_MODE_HEAT;
+      return climate::CLIMATE_MODE_COOL;
+    }
+
+    // writes from other components go through a climate call so home assistant sees the same state
+    bool LGAPHVACClimate::handle_request_write(WriteField field, uint8_t value)
+    {
+      auto call = this->make_call();
+
+      switch (field)
+      {
+        case WRITE_POWER_STATE:
+          if (value > 1)
+            return false;
+          call.set_mode(value == 0 ? climate::CLIMATE_MODE_OFF : lgap_mode_to_climate_mode(this->mode_));
+          break;
+        case WRITE_MODE:
+          if (value > 4)
+            return false;
+          // changing the mode of a zone that is off only changes the mode it will turn on in
+          if (this->power_state_ == 0)
+          {
+            this->mode_ = value;
+            this->write_update_pending = true;
+            return true;
+          }
+          call.set_mode(lgap_mode_to_climate_mode(value));
+          break;
+        case WRITE_SWING:
+          if (value > 1)
+            return false;
+          call.set_swing_mode(value == 1 ? climate::CLIMATE_SWING_VERTICAL : climate::CLIMATE_SWING_OFF);
+          break;
+        case WRITE_FAN_SPEED:
+          if (value > 2)
+            return false;
+          call.set_fan_mode(value == 0 ? climate::CLIMATE_FAN_LOW : (value == 1 ? climate::CLIMATE_FAN_MEDIUM : climate::CLIMATE_FAN_HIGH));
+          break;
+        case WRITE_TARGET_TEMPERATURE:
+          if (value < MIN_TEMPERATURE || value > MAX_WRITE_TEMPERATURE)
+            return false;
+          call.set_target_temperature(value);
+          break;
+        default:
+          return false;
+      }
+
+      call.perform();
+      return true;
+    }
+
     void LGAPHVACClimate::handle_generate_lgap_request(std::vector<uint8_t> &message, uint8_t &request_id)
     {
-      ESP_LOGD(TAG, "Generating %s request message for zone %d...", (this->write_update_pending ? "WRITE" : "READ"), this->zone_number);
+      LGAP_TRACE(this->parent_, TRACE_ZONE_REQUEST, this->zone_number, this->write_update_pending, 0);
 
       // only create a write request if there is a pending message
       int write_state = this->write_update_pending ? 2 : 0;
@@ -234,14 +301,12 @@ namespace esphome
 
       // blank val for checksum then replace with calculation
       message.push_back(0);
-      message[7] = this->parent_->calculate_checksum(message);
+      message[7] = this->parent_->calculate_checksum(message.data(), message.size());
     }
 
     // todo: add handling for when mode change is requested but mode is already on with another zone, ie can't choose heat when cool is already on
     void LGAPHVACClimate::handle_on_message_received(std::vector<uint8_t> &message)
     {
-      ESP_LOGD(TAG, "Processing climate message...");
-
       // handle bad class config
       if (this->zone_number < 0)
         return;
@@ -360,22 +425,20 @@ namespace esphome
       // TODO: implement precision setting for reported temperature
       // int current_temperature = ((70 - message[8] * 100.0 / 256.0)) / 100.0;
       int current_temperature = (message[8] & 0xf) + 15;
-      ESP_LOGD(TAG, "Current temperature: %d", current_temperature);
       // checks that temperature is different AND that the publish time interval has passed
       if (current_temperature != this->current_temperature_)
       {
         if (this->temperature_last_publish_time_ + this->temperature_publish_time_ <= millis())
         {
-          ESP_LOGD(TAG, "Temperature update time has lapsed. Sending update...");
           this->temperature_last_publish_time_ = millis();
           this->current_temperature_ = current_temperature;
           this->current_temperature = current_temperature;
           publish_update = true;
-        } else {
-          ESP_LOGD(TAG, "Temperature update time hasn't lapsed. Ignoring temperature difference...");
         }
       }
 
+      LGAP_TRACE(this->parent_, TRACE_ZONE_DECODE, this->zone_number, current_temperature, publish_update);
+
       // send update to home assistant with all the changed variables
       if (publish_update == true)
       {
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "../lgap.h"
 #include "../lgap_device.h"
 
@@ -7,6 +9,10 @@ namespace esphome
 {
   namespace lgap
   {
+    // the request only has 4 bits for target - 15, so these are the only setpoints that can be written
+    static const uint8_t MIN_WRITE_TEMPERATURE = 16;
+    static const uint8_t MAX_WRITE_TEMPERATURE = 30;
+
     class LGAPHVACClimate : public LGAPDevice, public climate::Climate
     {
       public:
@@ -40,6 +46,7 @@ namespace esphome
 
         void handle_on_message_received(std::vector<uint8_t> &message) override;
         void handle_generate_lgap_request(std::vector<uint8_t> &message, uint8_t &request_id) override;
+        bool handle_request_write(WriteField field, uint8_t value) override;
       };
 
   } // namespace lgap
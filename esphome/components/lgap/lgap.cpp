@@ -2,6 +2,7 @@
 #include "lgap_device.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
@@ -9,8 +10,24 @@ namespace esphome
 {
   namespace lgap
   {
+    static const size_t MAX_QUEUED_GROUP_WRITES = 4;
+
     float LGAP::get_setup_priority() const { return setup_priority::DATA; }
 
+    void LGAP::setup()
+    {
+      // one entry per configured zone. the table is never resized after this so pointers into it stay valid
+      this->zone_states_.reserve(this->devices_.size());
+      for (auto *device : this->devices_)
+      {
+        if (device->zone_number < 0 || this->find_zone_state_(device->zone_number) != nullptr)
+          continue;
+
+        this->zone_states_.push_back(ZoneState{});
+        this->zone_states_.back().zone_number = device->zone_number;
+      }
+    }
+
     void LGAP::dump_config()
     {
       ESP_LOGCONFIG(TAG, "LGAP:");
@@ -26,6 +43,7 @@ namespace esphome
         ESP_LOGCONFIG(TAG, "Flow control pin not set.");
       }
 
+      ESP_LOGCONFIG(TAG, "  Passive: %s", this->passive_ ? "true" : "false");
       ESP_LOGCONFIG(TAG, "  Loop wait time: %dms", this->loop_wait_time_);
       ESP_LOGCONFIG(TAG, "  Receive wait time: %dms", this->receive_wait_time_);
       ESP_LOGCONFIG(TAG, "  Child devices: %d", this->devices_.size());
@@ -33,15 +51,44 @@ namespace esphome
       {
         ESP_LOGCONFIG(TAG, "  Debug: true");
       }
+#ifdef USE_LGAP_TRACE
+      ESP_LOGCONFIG(TAG, "  Trace buffer size: %u events", this->trace_.size());
+#endif
+    }
+
+    void LGAP::dump_trace()
+    {
+#ifdef USE_LGAP_TRACE
+      uint32_t head = this->trace_.head();
+      uint32_t start = head > this->trace_.size() ? head - this->trace_.size() : 0;
+      uint32_t last_timestamp = 0;
+
+      ESP_LOGI(TAG, "Trace buffer (%" PRIu32 " events):", head - start);
+      for (uint32_t i = start; i < head; i++)
+      {
+        TraceEvent event;
+        if (!this->trace_.read(i, event))
+          continue;
+
+        // print the delta between events as it's the useful number for timing analysis
+        uint32_t delta = last_timestamp == 0 ? 0 : event.timestamp - last_timestamp;
+        last_timestamp = event.timestamp;
+        ESP_LOGI(TAG, "  %10" PRIu32 "us +%8" PRIu32 "us %-16s zone=%-3u arg0=0x%02X arg1=0x%02X", event.timestamp, delta,
+                 trace_event_type_to_string(event.type), event.zone, event.arg0, event.arg1);
+      }
+#else
+      ESP_LOGW(TAG, "Tracing is not enabled. Set trace_buffer_size to enable it.");
+#endif
     }
 
     // the checksum method is the same as the LG wall controller
     // borrowed this checksum function from:
     // https://github.com/JanM321/esphome-lg-controller/blob/998b78a212f798267feca0a91475726516228b56/esphome/lg-controller.h#L631C1-L637C6
-    uint8_t LGAP::calculate_checksum(const std::vector<uint8_t> &data)
+    // length includes the checksum byte at the end, which isn't summed
+    uint8_t LGAP::calculate_checksum(const uint8_t *data, size_t length)
     {
       size_t result = 0;
-      for (size_t i = 0; i < data.size() - 1; i++)
+      for (size_t i = 0; i < length - 1; i++)
       {
         result += data[i];
       }
@@ -50,8 +97,6 @@ namespace esphome
 
     void LGAP::clear_rx_buffer()
     {
-      ESP_LOGV(TAG, "Clearing rx buffer...");
-
       // clear internal rx buffer
       this->rx_buffer_.clear();
       // clear uart rx buffer
@@ -59,33 +104,391 @@ namespace esphome
         this->read();
     }
 
+    void LGAP::set_state_(State state)
+    {
+      LGAP_TRACE(this, TRACE_STATE, this->last_request_zone_, state, 0);
+      this->state_ = state;
+
+      // only spin the main loop while a transaction is in flight
+      if (state == State::REQUEST_NEXT_DEVICE_STATUS)
+        this->high_freq_.stop();
+      else
+        this->high_freq_.start();
+    }
+
+    LGAPDevice *LGAP::get_device(uint8_t zone_number)
+    {
+      for (auto *device : this->devices_)
+      {
+        if (device->zone_number == zone_number)
+          return device;
+      }
+      return nullptr;
+    }
+
+    const ZoneState *LGAP::get_zone_state(uint8_t zone_number)
+    {
+      // the sequence is only 0 until the first response has been decoded
+      const ZoneState *zone_state = this->find_zone_state_(zone_number);
+      if (zone_state == nullptr || zone_state->sequence == 0)
+        return nullptr;
+      return zone_state;
+    }
+
+    ZoneState *LGAP::find_zone_state_(uint8_t zone_number)
+    {
+      for (auto &zone_state : this->zone_states_)
+      {
+        if (zone_state.zone_number == zone_number)
+          return &zone_state;
+      }
+      return nullptr;
+    }
+
+    const ZoneState *LGAP::get_zone_state(uint8_t zone_number, uint32_t max_age_ms)
+    {
+      const ZoneState *zone_state = this->get_zone_state(zone_number);
+      if (zone_state != nullptr && (millis() - zone_state->last_update_time) <= max_age_ms)
+        return zone_state;
+
+      this->request_refresh(zone_number);
+      return nullptr;
+    }
+
+    void LGAP::request_refresh(uint8_t zone_number)
+    {
+      // passive mode has to wait for the other master to poll the zone
+      if (this->passive_ || this->get_device(zone_number) == nullptr)
+        return;
+
+      // readers asking for the same zone share the same poll
+      if (std::find(this->refresh_queue_.begin(), this->refresh_queue_.end(), zone_number) == this->refresh_queue_.end())
+        this->refresh_queue_.push_back(zone_number);
+    }
+
+    void LGAP::update_zone_state_(const std::vector<uint8_t> &response)
+    {
+      // zones without a device aren't in the table, passive mode sees every zone the other master polls
+      ZoneState *zone_state = this->find_zone_state_(response[4]);
+      if (zone_state == nullptr)
+        return;
+
+      // same decoding as the climate entity, see protocol.md for the response layout
+      ZoneState decoded = *zone_state;
+      decoded.power_state = response[1] & 1;
+      decoded.idu_connected = (response[1] >> 1) & 1;
+      decoded.mode = response[6] & 7;
+      decoded.swing = (response[6] >> 3) & 1;
+      decoded.fan_speed = (response[6] >> 4) & 7;
+      decoded.target_temperature = (response[7] & 0xf) + 15;
+      decoded.room_temperature = (response[8] & 0xf) + 15;
+      decoded.pipe_in_temperature = (response[9] & 0xf) + 15;
+      decoded.pipe_out_temperature = (response[10] & 0xf) + 15;
+      decoded.last_update_time = millis();
+
+      // the first response for a zone always counts as a change
+      if (zone_state->sequence == 0 ||
+          decoded.power_state != zone_state->power_state ||
+          decoded.idu_connected != zone_state->idu_connected ||
+          decoded.mode != zone_state->mode ||
+          decoded.swing != zone_state->swing ||
+          decoded.fan_speed != zone_state->fan_speed ||
+          decoded.target_temperature != zone_state->target_temperature ||
+          decoded.room_temperature != zone_state->room_temperature ||
+          decoded.pipe_in_temperature != zone_state->pipe_in_temperature ||
+          decoded.pipe_out_temperature != zone_state->pipe_out_temperature)
+      {
+        // 0 is reserved for zones that have never responded
+        if (++this->state_sequence_ == 0)
+          this->state_sequence_++;
+        decoded.sequence = this->state_sequence_;
+      }
+
+      *zone_state = decoded;
+
+      // a response for a zone is as good as a priority refresh, however it was triggered
+      auto it = std::find(this->refresh_queue_.begin(), this->refresh_queue_.end(), response[4]);
+      if (it != this->refresh_queue_.end())
+        this->refresh_queue_.erase(it);
+    }
+
+    void LGAP::queue_group_write(const std::vector<LGAPDevice *> &devices)
+    {
+      if (this->passive_)
+      {
+        ESP_LOGW(TAG, "Group writes are not possible in passive mode. Ignoring...");
+        return;
+      }
+
+      std::vector<LGAPDevice *> group;
+      bool already_queued = false;
+      for (auto *device : devices)
+      {
+        if (device->zone_number < 0)
+          continue;
+
+        // zones waiting in a group that hasn't started yet send their latest pending state when it runs
+        if (this->is_group_write_queued_(device))
+        {
+          already_queued = true;
+          continue;
+        }
+        group.push_back(device);
+      }
+
+      if (group.size() == 0)
+      {
+        if (!already_queued)
+          ESP_LOGW(TAG, "Group write has no zones with a valid zone number. Ignoring...");
+        return;
+      }
+
+      // every queued group stops round robin polling while it runs, so don't let them pile up.
+      // dropped zones keep their pending write and send it on their next round robin turn
+      if (this->group_write_queue_.size() >= MAX_QUEUED_GROUP_WRITES)
+      {
+        ESP_LOGW(TAG, "Group write queue is full. Ignoring...");
+        return;
+      }
+
+      ESP_LOGD(TAG, "Queueing group write for %u zones", (unsigned) group.size());
+      this->group_write_queue_.push_back(group);
+
+      // group writes don't wait for the next poll, so wake up if the loop is sleeping
+      this->cancel_timeout("poll");
+      this->enable_loop();
+    }
+
+    bool LGAP::is_group_write_queued_(LGAPDevice *device)
+    {
+      for (auto &group : this->group_write_queue_)
+      {
+        if (std::find(group.begin(), group.end(), device) != group.end())
+          return true;
+      }
+      return false;
+    }
+
+    void LGAP::start_group_write_()
+    {
+      this->sweep_devices_ = this->group_write_queue_.front();
+      this->group_write_queue_.erase(this->group_write_queue_.begin());
+
+      this->sweep_expected_.assign(this->sweep_devices_.size(), SweepZoneState{});
+      this->sweep_results_.assign(this->sweep_devices_.size(), false);
+      this->sweep_index_ = 0;
+      this->sweep_start_time_ = millis();
+      this->sweep_phase_ = SweepPhase::SWEEP_WRITE;
+    }
+
+    LGAPDevice *LGAP::next_device_()
+    {
+      if (this->sweep_phase_ == SweepPhase::SWEEP_IDLE)
+      {
+        // zones with stale state requested by a reader jump the queue
+        while (this->refresh_queue_.size() > 0)
+        {
+          LGAPDevice *device = this->get_device(this->refresh_queue_.front());
+          this->refresh_queue_.erase(this->refresh_queue_.begin());
+          if (device != nullptr)
+            return device;
+        }
+
+        // cycle through zones
+        this->last_zone_checked_index_ = (this->last_zone_checked_index_ + 1) > this->devices_.size() - 1 ? 0 : this->last_zone_checked_index_ + 1;
+        return this->devices_[this->last_zone_checked_index_];
+      }
+
+      // the write sweep always writes, the verify sweep only reads unless the zone was changed again in the meantime
+      LGAPDevice *device = this->sweep_devices_[this->sweep_index_];
+      if (this->sweep_phase_ == SweepPhase::SWEEP_WRITE)
+        device->write_update_pending = true;
+      return device;
+    }
+
+    void LGAP::complete_request_(const std::vector<uint8_t> *response)
+    {
+      if (this->sweep_phase_ == SweepPhase::SWEEP_IDLE)
+        return;
+
+      // write results are only known once the zone has been read back
+      if (this->sweep_phase_ == SweepPhase::SWEEP_VERIFY)
+      {
+        const SweepZoneState &expected = this->sweep_expected_[this->sweep_index_];
+        this->sweep_results_[this->sweep_index_] = response != nullptr &&
+                                                   ((*response)[1] & 1) == expected.power_state &&
+                                                   ((*response)[6] & 0x7f) == expected.mode_swing_fan &&
+                                                   ((*response)[7] & 0xf) == expected.target_temperature;
+      }
+
+      this->sweep_index_++;
+      if (this->sweep_index_ < this->sweep_devices_.size())
+        return;
+
+      this->sweep_index_ = 0;
+      if (this->sweep_phase_ == SweepPhase::SWEEP_WRITE)
+      {
+        this->sweep_phase_ = SweepPhase::SWEEP_VERIFY;
+        return;
+      }
+
+      // report results
+      uint32_t elapsed = millis() - this->sweep_start_time_;
+      uint16_t total = this->sweep_devices_.size();
+      std::vector<uint8_t> failed_zones;
+      for (size_t i = 0; i < this->sweep_devices_.size(); i++)
+      {
+        if (!this->sweep_results_[i])
+        {
+          ESP_LOGW(TAG, "Group write to zone %d could not be verified", this->sweep_devices_[i]->zone_number);
+          failed_zones.push_back(this->sweep_devices_[i]->zone_number);
+        }
+      }
+      uint16_t succeeded = total - failed_zones.size();
+      ESP_LOGD(TAG, "Group write finished in %" PRIu32 "ms. %u/%u zones verified", elapsed, succeeded, total);
+
+      this->sweep_phase_ = SweepPhase::SWEEP_IDLE;
+      this->group_write_complete_callback_.call(elapsed, succeeded, total, failed_zones);
+    }
+
+    // responses are recognised by their 0x10 first byte and 16 byte length, anything else is an 8 byte request.
+    // frames that fail the checksum are resynced one byte at a time
+    void LGAP::passive_loop_()
+    {
+      while (this->available())
+      {
+        uint8_t c;
+        read_byte(&c);
+        LGAP_TRACE(this, TRACE_RX_BYTE, this->last_request_zone_, c, this->rx_buffer_.size());
+        this->rx_buffer_.push_back(c);
+        this->last_receive_time_ = millis();
+
+        while (true)
+        {
+          // the last frame can end exactly on the last byte read
+          if (this->rx_buffer_.empty())
+            break;
+
+          size_t length = this->rx_buffer_[0] == 0x10 ? 16 : 8;
+          if (this->rx_buffer_.size() < length)
+            break;
+
+          if (calculate_checksum(this->rx_buffer_.data(), length) != this->rx_buffer_[length - 1])
+          {
+            this->rx_buffer_.erase(this->rx_buffer_.begin());
+            continue;
+          }
+
+          // only valid frames are copied out, into a buffer that keeps its capacity between frames
+          this->passive_frame_.assign(this->rx_buffer_.begin(), this->rx_buffer_.begin() + length);
+          this->rx_buffer_.erase(this->rx_buffer_.begin(), this->rx_buffer_.begin() + length);
+          this->process_passive_frame_(this->passive_frame_);
+        }
+      }
+
+      // leftover noise would otherwise hold the high frequency loop forever
+      if (this->rx_buffer_.size() > 0 && (millis() - this->last_receive_time_) > this->receive_wait_time_)
+      {
+        ESP_LOGD(TAG, "Dropping %u bytes of partial frame", (unsigned) this->rx_buffer_.size());
+        LGAP_TRACE(this, TRACE_TIMEOUT, this->last_request_zone_, 0, 0);
+        this->rx_buffer_.clear();
+      }
+
+      // the other master decides when requests happen, so only speed up between a request and its response
+      bool awaiting_response = this->passive_request_pending_ && (this->receive_until_time_ - millis()) <= this->receive_wait_time_;
+      if (awaiting_response || this->rx_buffer_.size() > 0)
+        this->high_freq_.start();
+      else
+        this->high_freq_.stop();
+    }
+
+    void LGAP::process_passive_frame_(std::vector<uint8_t> &frame)
+    {
+      // remember the request so the response can be paired with it
+      if (frame.size() == 8)
+      {
+        LGAP_TRACE(this, TRACE_RX_REQUEST, frame[3], frame[2], (frame[4] >> 1) & 1);
+        this->last_request_zone_ = frame[3];
+        this->last_request_id_ = frame[2];
+        this->receive_until_time_ = millis() + this->receive_wait_time_;
+        this->passive_request_pending_ = true;
+        return;
+      }
+
+      bool matched = this->passive_request_pending_ &&
+                     (this->receive_until_time_ - millis()) <= this->receive_wait_time_ &&
+                     frame[4] == this->last_request_zone_ &&
+                     frame[2] == this->last_request_id_;
+      this->passive_request_pending_ = false;
+      LGAP_TRACE(this, TRACE_RX_RESPONSE, frame[4], frame[2], matched);
+
+      if (!matched)
+      {
+        ESP_LOGD(TAG, "Response for zone %d does not match the last request seen. Ignoring...", frame[4]);
+        return;
+      }
+
+      for (auto &device : this->devices_)
+      {
+        if (device->zone_number == frame[4])
+          device->on_message_received(frame);
+      }
+      this->update_zone_state_(frame);
+    }
+
     void LGAP::loop()
     {
+      // never transmit in passive mode, only decode what the other master is doing
+      if (this->passive_)
+      {
+        this->passive_loop_();
+        return;
+      }
+
       // do nothing if there are no LGAP devices registered
       if (this->devices_.size() == 0)
+      {
+        this->disable_loop();
         return;
+      }
 
       if (this->state_ == State::REQUEST_NEXT_DEVICE_STATUS)
       {
-        // enable wait time between loops
-        if ((millis() - this->last_loop_time_) < this->loop_wait_time_)
-          return;
-        else
-          this->last_loop_time_ = millis();
+        // start the next queued group write once the bus is free
+        if (this->sweep_phase_ == SweepPhase::SWEEP_IDLE && this->group_write_queue_.size() > 0)
+          this->start_group_write_();
 
-        ESP_LOGV(TAG, "REQUEST_NEXT_DEVICE_STATUS");
+        // enable wait time between loops, group writes are sent back to back
+        if (this->sweep_phase_ == SweepPhase::SWEEP_IDLE)
+        {
+          uint32_t elapsed = millis() - this->last_loop_time_;
+          if (elapsed < this->loop_wait_time_)
+          {
+            // nothing to do until the next poll is due, sleep instead of checking on every loop
+            this->disable_loop();
+            this->set_timeout("poll", this->loop_wait_time_ - elapsed, [this]()
+                              { this->enable_loop(); });
+            return;
+          }
+          else
+            this->last_loop_time_ = millis();
+        }
 
-        // cycle through zones
-        this->last_zone_checked_index_ = (this->last_zone_checked_index_ + 1) > this->devices_.size() - 1 ? 0 : this->last_zone_checked_index_ + 1;
-        ESP_LOGV(TAG, "devices_[%d]->zone_number = %d", this->last_zone_checked_index_, this->devices_[this->last_zone_checked_index_]->zone_number);
+        LGAPDevice *device = this->next_device_();
 
         // retrieve lgap message from device if it has a valid zone number
-        if (this->devices_[this->last_zone_checked_index_]->zone_number > -1)
+        if (device->zone_number > -1)
         {
-          ESP_LOGV(TAG, "Requesting update from zone %d", this->devices_[this->last_zone_checked_index_]->zone_number);
-
           this->tx_buffer_.clear();
-          this->devices_[this->last_zone_checked_index_]->generate_lgap_request(this->tx_buffer_, this->last_request_id_);
+          device->generate_lgap_request(this->tx_buffer_, this->last_request_id_);
+
+          // keep the written state of group write zones to verify against later
+          if (this->sweep_phase_ != SweepPhase::SWEEP_IDLE && device->write_update_pending == true)
+          {
+            this->sweep_expected_[this->sweep_index_].power_state = this->tx_buffer_[4] & 1;
+            this->sweep_expected_[this->sweep_index_].mode_swing_fan = this->tx_buffer_[5] & 0x7f;
+            this->sweep_expected_[this->sweep_index_].target_temperature = this->tx_buffer_[6] & 0xf;
+          }
 
           // signal flow control write mode enabled
           if (this->flow_control_pin_ != nullptr)
@@ -94,6 +497,7 @@ namespace esphome
           // send data over uart
           this->write_array(this->tx_buffer_.data(), this->tx_buffer_.size());
           this->flush();
+          LGAP_TRACE(this, TRACE_TX_REQUEST, this->tx_buffer_[3], this->tx_buffer_[2], (this->tx_buffer_[4] >> 1) & 1);
           this->tx_buffer_.clear();
 
           // signal flow control write mode disabled
@@ -101,18 +505,15 @@ namespace esphome
             this->flow_control_pin_->digital_write(false);
 
           // update device state
-          if (this->devices_[this->last_zone_checked_index_]->write_update_pending == true)
-          {
-            ESP_LOGV(TAG, "Disabling write flag for zone %d", this->devices_[this->last_zone_checked_index_]->zone_number);
-            this->devices_[this->last_zone_checked_index_]->write_update_pending = false;
-          }
+          if (device->write_update_pending == true)
+            device->write_update_pending = false;
 
           // update state for last request
-          this->last_request_zone_ = this->devices_[this->last_zone_checked_index_]->zone_number;
+          this->last_request_zone_ = device->zone_number;
           this->receive_until_time_ = millis() + this->receive_wait_time_;
 
           // update state machine
-          this->state_ = State::PROCESS_DEVICE_STATUS_START;
+          this->set_state_(State::PROCESS_DEVICE_STATUS_START);
         }
 
         // will overflow back to 0 when it reaches the top
@@ -125,9 +526,11 @@ namespace esphome
       if ((this->receive_until_time_ - millis()) > this->receive_wait_time_)
       {
         ESP_LOGE(TAG, "Last receive time exceeded. Clearing buffer...");
+        LGAP_TRACE(this, TRACE_TIMEOUT, this->last_request_zone_, 0, 0);
         clear_rx_buffer();
+        this->complete_request_(nullptr);
 
-        this->state_ = State::REQUEST_NEXT_DEVICE_STATUS;
+        this->set_state_(State::REQUEST_NEXT_DEVICE_STATUS);
         return;
       }
 
@@ -136,29 +539,27 @@ namespace esphome
         // read byte and process
         uint8_t c;
         read_byte(&c);
-        ESP_LOGV(TAG, "Received Byte  %d (0X%x)", c, c);
+        LGAP_TRACE(this, TRACE_RX_BYTE, this->last_request_zone_, c, this->rx_buffer_.size());
 
         // read the start of a new response
         if (this->state_ == State::PROCESS_DEVICE_STATUS_START)
         {
-          ESP_LOGV(TAG, "PROCESS_DEVICE_STATUS_START");
-
           // handle valid start of response
           if (c == 0x10 && this->rx_buffer_.size() == 0)
           {
-            ESP_LOGV(TAG, "Received start of new response");
-
             this->rx_buffer_.clear();
             this->rx_buffer_.push_back(c);
 
-            this->state_ = State::PROCESS_DEVICE_STATUS_CONTINUE;
+            this->set_state_(State::PROCESS_DEVICE_STATUS_CONTINUE);
           }
           // handle invalid start of response
           else
           {
             ESP_LOGE(TAG, "Received invalid start of response. Clearing buffer...");
+            LGAP_TRACE(this, TRACE_RX_INVALID_START, this->last_request_zone_, c, 0);
             clear_rx_buffer();
-            this->state_ = State::REQUEST_NEXT_DEVICE_STATUS;
+            this->complete_request_(nullptr);
+            this->set_state_(State::REQUEST_NEXT_DEVICE_STATUS);
           }
 
           return;
@@ -166,8 +567,6 @@ namespace esphome
 
         if (this->state_ == State::PROCESS_DEVICE_STATUS_CONTINUE)
         {
-          ESP_LOGV(TAG, "PROCESS_DEVICE_STATUS_CONTINUE");
-
           // add byte to rx buffer
           this->rx_buffer_.push_back(c);
 
@@ -175,13 +574,15 @@ namespace esphome
           if (this->rx_buffer_.size() == 16)
           {
             // handle bad checksum
-            if (calculate_checksum(this->rx_buffer_) != this->rx_buffer_[this->rx_buffer_.size() - 1])
+            if (calculate_checksum(this->rx_buffer_.data(), this->rx_buffer_.size()) != this->rx_buffer_[this->rx_buffer_.size() - 1])
             {
               // todo: include response bytes in printout
               ESP_LOGD(TAG, "Checksum failed for response");
+              LGAP_TRACE(this, TRACE_CHECKSUM_FAIL, this->last_request_zone_, calculate_checksum(this->rx_buffer_.data(), this->rx_buffer_.size()), this->rx_buffer_[this->rx_buffer_.size() - 1]);
               clear_rx_buffer();
+              this->complete_request_(nullptr);
 
-              this->state_ = State::REQUEST_NEXT_DEVICE_STATUS;
+              this->set_state_(State::REQUEST_NEXT_DEVICE_STATUS);
               return;
             }
 
@@ -189,26 +590,32 @@ namespace esphome
             // check to see if the response is for the last request (request/response is in order)
             if (this->rx_buffer_[4] == this->last_request_zone_ && (this->rx_buffer_[2] == (this->last_request_id_ - 1) || this->rx_buffer_[2] == (this->last_request_id_)))
             {
+              LGAP_TRACE(this, TRACE_RX_RESPONSE, this->rx_buffer_[4], this->rx_buffer_[2], 1);
+
               // notify valid device components
               for (auto &device : this->devices_)
               {
                 if (device->zone_number == this->rx_buffer_[4])
                 {
-                  ESP_LOGD(TAG, "Valid message. Notifying zone %d...", this->last_request_zone_);
                   device->on_message_received(this->rx_buffer_);
                 }
               }
+
+              this->update_zone_state_(this->rx_buffer_);
+              this->complete_request_(&this->rx_buffer_);
             }
             else
             {
+              LGAP_TRACE(this, TRACE_RX_RESPONSE, this->rx_buffer_[4], this->rx_buffer_[2], 0);
               ESP_LOGD(TAG, "Response does not match last request ID. Ignoring...");
               ESP_LOGV(TAG, "rx_buffer[2] (%d) == last_request_id_   (%d)", this->rx_buffer_[2], (this->last_request_id_ - 1));
               ESP_LOGV(TAG, "rx_buffer[4] (%d) == last_request_zone_ (%d)", this->rx_buffer_[4], this->last_request_zone_);
+              this->complete_request_(nullptr);
             }
 
             // reset state
             clear_rx_buffer();
-            this->state_ = State::REQUEST_NEXT_DEVICE_STATUS;
+            this->set_state_(State::REQUEST_NEXT_DEVICE_STATUS);
             return;
           }
         }
@@ -2,8 +2,10 @@
 
 #include "esphome/core/component.h"
 #include "esphome/components/uart/uart.h"
+#include "esphome/core/helpers.h"
 #include <vector>
 #include "lgap_device.h"
+#include "lgap_trace.h"
 
 namespace esphome
 {
@@ -18,14 +20,49 @@ namespace esphome
       PROCESS_DEVICE_STATUS_CONTINUE
     };
 
+    enum SweepPhase
+    {
+      SWEEP_IDLE,
+      SWEEP_WRITE,
+      SWEEP_VERIFY
+    };
+
+    // state written to a zone during a group write, in the same bit layout as the response
+    struct SweepZoneState
+    {
+      uint8_t power_state{0};
+      uint8_t mode_swing_fan{0};
+      uint8_t target_temperature{0};
+    };
+
+    // decoded state of a zone, kept small so the whole table stays in a few cache lines
+    struct ZoneState
+    {
+      uint32_t last_update_time{0};
+      // value of LGAP::get_state_sequence() when any field below last changed
+      uint32_t sequence{0};
+      uint8_t zone_number{0};
+      uint8_t power_state{0};
+      uint8_t idu_connected{0};
+      uint8_t mode{0};
+      uint8_t swing{0};
+      uint8_t fan_speed{0};
+      // temperatures are in whole degrees celsius
+      uint8_t target_temperature{0};
+      uint8_t room_temperature{0};
+      uint8_t pipe_in_temperature{0};
+      uint8_t pipe_out_temperature{0};
+    };
+
     class LGAP : public uart::UARTDevice, public Component
     {
       public:
-        uint8_t calculate_checksum(const std::vector<uint8_t> &data);
+        uint8_t calculate_checksum(const uint8_t *data, size_t length);
         const char *const TAG = "lgap";
 
         // load this class after the UART is instantiated
         float get_setup_priority() const override;
+        void setup() override;
         void dump_config() override;
         void loop() override;
 
@@ -34,19 +71,64 @@ namespace esphome
 
         void set_flow_control_pin(GPIOPin *flow_control_pin) { this->flow_control_pin_ = flow_control_pin; }
         void set_receive_wait_time(uint16_t time_in_ms) { this->receive_wait_time_ = time_in_ms; }
+        // passive mode never transmits, state comes from another master polling the bus
+        void set_passive(bool passive) { this->passive_ = passive; }
+        bool is_passive() const { return this->passive_; }
         void register_device(LGAPDevice *device)
         {
           ESP_LOGD(TAG, "Registering device");
           this->devices_.push_back(device);
         }
 
+        // writes the pending state of every device back to back, then reads them all back to verify
+        void queue_group_write(const std::vector<LGAPDevice *> &devices);
+        LGAPDevice *get_device(uint8_t zone_number);
+
+        // returns the cached state of a zone if it is younger than max_age_ms. otherwise returns
+        // nullptr and moves the zone to the front of the polling order so all readers share one poll.
+        // the table is sized in setup() and never moves, so the pointer stays valid but its contents
+        // are updated in place by loop(). copy the struct if a consistent snapshot is needed later
+        const ZoneState *get_zone_state(uint8_t zone_number, uint32_t max_age_ms);
+        // returns the cached state of a configured zone regardless of age, nullptr if it has never responded
+        const ZoneState *get_zone_state(uint8_t zone_number);
+        // increments every time the state of any zone changes
+        uint32_t get_state_sequence() const { return this->state_sequence_; }
+        void request_refresh(uint8_t zone_number);
+
+        // called with the elapsed time, verified zone count, total zone count and the zone numbers that failed verification
+        void add_on_group_write_complete_callback(std::function<void(uint32_t, uint16_t, uint16_t, const std::vector<uint8_t> &)> &&callback)
+        {
+          this->group_write_complete_callback_.add(std::move(callback));
+        }
+
+        // logs the contents of the trace buffer, can be called from a lambda
+        void dump_trace();
+#ifdef USE_LGAP_TRACE
+        void set_trace_buffer_size(uint16_t size) { this->trace_.init(size); }
+        inline void record_trace(TraceEventType type, uint8_t zone, uint8_t arg0, uint8_t arg1)
+        {
+          this->trace_.record(type, zone, arg0, arg1);
+        }
+#endif
+
       protected:
         void clear_rx_buffer();
+        void set_state_(State state);
+        void passive_loop_();
+        void process_passive_frame_(std::vector<uint8_t> &frame);
+        LGAPDevice *next_device_();
+        void start_group_write_();
+        bool is_group_write_queued_(LGAPDevice *device);
+        void complete_request_(const std::vector<uint8_t> *response);
+        void update_zone_state_(const std::vector<uint8_t> &response);
+        ZoneState *find_zone_state_(uint8_t zone_number);
 
         GPIOPin *flow_control_pin_{nullptr};
 
         State state_{REQUEST_NEXT_DEVICE_STATUS};
         bool debug_{true};
+        bool passive_{false};
+        bool passive_request_pending_{false};
         int last_zone_checked_index_{-1};
 
         uint16_t loop_wait_time_{500};
@@ -60,12 +142,37 @@ namespace esphome
         uint32_t last_loop_time_{0};
         uint32_t last_zone_check_time_{0};
         uint32_t receive_until_time_{0};
+        // last byte seen in passive mode, partial frames are dropped once the bus has been quiet for receive_wait_time_
+        uint32_t last_receive_time_{0};
 
         std::vector<uint8_t> rx_buffer_;
+        std::vector<uint8_t> passive_frame_;
         std::vector<uint8_t> tx_buffer_;
 
+        // held while a transaction is in flight, released when idle
+        HighFrequencyLoopRequester high_freq_;
+
         std::vector<LGAPDevice *> devices_{};
 
+        // group writes
+        std::vector<std::vector<LGAPDevice *>> group_write_queue_{};
+        std::vector<LGAPDevice *> sweep_devices_{};
+        std::vector<SweepZoneState> sweep_expected_{};
+        std::vector<bool> sweep_results_{};
+        size_t sweep_index_{0};
+        SweepPhase sweep_phase_{SWEEP_IDLE};
+        uint32_t sweep_start_time_{0};
+        CallbackManager<void(uint32_t, uint16_t, uint16_t, const std::vector<uint8_t> &)> group_write_complete_callback_{};
+
+        // zone state cache
+        std::vector<ZoneState> zone_states_{};
+        std::vector<uint8_t> refresh_queue_{};
+        uint32_t state_sequence_{0};
+
+#ifdef USE_LGAP_TRACE
+        TraceBuffer trace_;
+#endif
+
     };
   } // namespace lgap
 } // namespace esphome
\ No newline at end of file
@@ -17,6 +17,11 @@ namespace esphome
       this->handle_generate_lgap_request(message, request_id);
     }
 
+    bool LGAPDevice::request_write(WriteField field, uint8_t value)
+    {
+      return this->handle_request_write(field, value);
+    }
+
 
   } // namespace lgap
 } // namespace esphome
\ No newline at end of file
@@ -9,6 +9,16 @@ namespace esphome
   {
     class LGAP;
 
+    // fields that can be written from outside of the device, values use the raw LGAP encoding
+    enum WriteField
+    {
+      WRITE_POWER_STATE,
+      WRITE_MODE,
+      WRITE_SWING,
+      WRITE_FAN_SPEED,
+      WRITE_TARGET_TEMPERATURE
+    };
+
     class LGAPDevice : public Component
     {
       public:
@@ -16,10 +26,12 @@ namespace esphome
         bool write_update_pending{false};
         
         void set_parent(LGAP *parent) { parent_ = parent; }
+        LGAP *get_parent() const { return parent_; }
         void set_zone_number(int zone_number) { this->zone_number = zone_number; }
 
         void on_message_received(std::vector<uint8_t> &message);
         void generate_lgap_request(std::vector<uint8_t> &message, uint8_t &request_id);
+        bool request_write(WriteField field, uint8_t value);
         
         // uint32_t last_uart_update_time_{0};
         // uint32_t last_ha_update_time_{0};
@@ -32,6 +44,7 @@ namespace esphome
 
         virtual void handle_on_message_received(std::vector<uint8_t> &message) = 0;
         virtual void handle_generate_lgap_request(std::vector<uint8_t> &message, uint8_t &request_id) = 0;
+        virtual bool handle_request_write(WriteField field, uint8_t value) = 0;
     };
 
   } // namespace lgap
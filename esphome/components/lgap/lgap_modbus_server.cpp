@@ -0,0 +1,444 @@
+#include "lgap_modbus_server.h"
+#include "lgap.h"
+#include "lgap_device.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include <algorithm>
+#include <cinttypes>
+
+namespace esphome
+{
+  namespace lgap
+  {
+    // every zone owns a block of 16 addresses in each register table, zone n starts at n * 16
+    static const uint16_t ZONE_BLOCK_SIZE = 16;
+
+    // coils
+    static const uint8_t COIL_POWER_STATE = 0;
+    static const uint8_t COIL_SWING = 1;
+    // discrete inputs
+    static const uint8_t DISCRETE_IDU_CONNECTED = 0;
+    // holding registers
+    static const uint8_t HOLDING_MODE = 0;
+    static const uint8_t HOLDING_FAN_SPEED = 1;
+    static const uint8_t HOLDING_TARGET_TEMPERATURE = 2;
+    // input registers
+    static const uint8_t INPUT_ROOM_TEMPERATURE = 1;
+    static const uint8_t INPUT_PIPE_IN_TEMPERATURE = 2;
+    static const uint8_t INPUT_PIPE_OUT_TEMPERATURE = 3;
+    // not part of the PMBUSB00A layout, lets clients judge how fresh the cached state is
+    static const uint8_t INPUT_STATE_SEQUENCE = 14;
+    static const uint8_t INPUT_STATE_AGE = 15;
+
+    static const uint8_t EXCEPTION_ILLEGAL_FUNCTION = 0x01;
+    static const uint8_t EXCEPTION_ILLEGAL_DATA_ADDRESS = 0x02;
+    static const uint8_t EXCEPTION_ILLEGAL_DATA_VALUE = 0x03;
+    static const uint8_t EXCEPTION_SERVER_DEVICE_FAILURE = 0x04;
+
+    // no valid RTU frame is longer than this
+    static const size_t MAX_FRAME_LENGTH = 256;
+
+    static uint16_t calculate_crc(const uint8_t *data, size_t length)
+    {
+      uint16_t crc = 0xFFFF;
+      for (size_t i = 0; i < length; i++)
+      {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+          if (crc & 1)
+            crc = (crc >> 1) ^ 0xA001;
+          else
+            crc >>= 1;
+        }
+      }
+      return crc;
+    }
+
+    float LGAPModbusServer::get_setup_priority() const { return setup_priority::DATA; }
+
+    void LGAPModbusServer::setup()
+    {
+      // a frame ends after 3.5 characters of silence (11 bits each), fixed at 1750us above 19200 baud
+      uint32_t baud_rate = this->parent_->get_baud_rate();
+      this->frame_gap_ = baud_rate > 19200 ? 1750 : 38500000UL / baud_rate;
+
+      if (this->flow_control_pin_ != nullptr)
+      {
+        this->flow_control_pin_->setup();
+        this->flow_control_pin_->digital_write(false);
+      }
+    }
+
+    void LGAPModbusServer::dump_config()
+    {
+      ESP_LOGCONFIG(TAG, "LGAP Modbus Server:");
+      ESP_LOGCONFIG(TAG, "  Address: %d", this->address_);
+      ESP_LOGCONFIG(TAG, "  Frame gap: %" PRIu32 "us", this->frame_gap_);
+      ESP_LOGCONFIG(TAG, "  Flow Control Pin:");
+      if (this->flow_control_pin_ != nullptr)
+      {
+        this->flow_control_pin_->dump_summary();
+      }
+      else
+      {
+        ESP_LOGCONFIG(TAG, "Flow control pin not set.");
+      }
+    }
+
+    // returns the full frame length including crc, or 0 if it isn't known yet
+    size_t LGAPModbusServer::expected_frame_length_()
+    {
+      if (this->rx_buffer_.size() < 2)
+        return 0;
+
+      switch (this->rx_buffer_[1])
+      {
+        case 0x01:
+        case 0x02:
+        case 0x03:
+        case 0x04:
+        case 0x05:
+        case 0x06:
+          return 8;
+        case 0x0F:
+        case 0x10:
+          return this->rx_buffer_.size() < 7 ? 0 : 9 + this->rx_buffer_[6];
+        default:
+          return 0;
+      }
+    }
+
+    void LGAPModbusServer::loop()
+    {
+      uint32_t now = micros();
+
+      // read whatever is already waiting before deciding the frame has ended, the loop may have stalled
+      while (this->available())
+      {
+        uint8_t c;
+        this->read_byte(&c);
+        this->rx_buffer_.push_back(c);
+        this->last_byte_time_ = now;
+
+        // nothing valid is this long, so we've lost sync on an unknown function code
+        if (this->rx_buffer_.size() > MAX_FRAME_LENGTH)
+          this->rx_buffer_.erase(this->rx_buffer_.begin());
+
+        while (true)
+        {
+          size_t length = this->expected_frame_length_();
+          if (length == 0 || this->rx_buffer_.size() < length)
+            break;
+
+          if (calculate_crc(this->rx_buffer_.data(), length) == 0)
+          {
+            this->process_frame_();
+            this->rx_buffer_.erase(this->rx_buffer_.begin(), this->rx_buffer_.begin() + length);
+          }
+          else
+          {
+            // bad crc means we're out of sync, try again from the next byte
+            this->rx_buffer_.erase(this->rx_buffer_.begin());
+          }
+        }
+      }
+
+      // unsupported function codes can only be framed by the silence after them
+      if (this->rx_buffer_.size() > 0 && (now - this->last_byte_time_) > this->frame_gap_)
+      {
+        if (this->rx_buffer_.size() >= 4 && this->rx_buffer_[0] == this->address_ && calculate_crc(this->rx_buffer_.data(), this->rx_buffer_.size()) == 0)
+          this->send_exception_(this->rx_buffer_[1], EXCEPTION_ILLEGAL_FUNCTION);
+        this->rx_buffer_.clear();
+      }
+    }
+
+    void LGAPModbusServer::process_frame_()
+    {
+      uint8_t address = this->rx_buffer_[0];
+      uint8_t function = this->rx_buffer_[1];
+
+      // address 0 is broadcast, writes are applied but never answered
+      if (address != this->address_ && address != 0)
+        return;
+      bool broadcast = address == 0;
+
+      uint16_t start = encode_uint16(this->rx_buffer_[2], this->rx_buffer_[3]);
+      uint16_t quantity = encode_uint16(this->rx_buffer_[4], this->rx_buffer_[5]);
+      uint8_t exception = 0;
+
+      this->tx_buffer_.clear();
+      this->tx_buffer_.push_back(this->address_);
+      this->tx_buffer_.push_back(function);
+      this->written_devices_.clear();
+
+      // writes can't be forwarded while another master owns the LGAP bus
+      bool write = function == 0x05 || function == 0x06 || function == 0x0F || function == 0x10;
+      if (write && this->lgap_->is_passive())
+      {
+        if (!broadcast)
+          this->send_exception_(function, EXCEPTION_SERVER_DEVICE_FAILURE);
+        return;
+      }
+
+      switch (function)
+      {
+        // read coils / discrete inputs
+        case 0x01:
+        case 0x02:
+        {
+          if (quantity < 1 || quantity > 2000)
+          {
+            exception = EXCEPTION_ILLEGAL_DATA_VALUE;
+            break;
+          }
+
+          this->tx_buffer_.push_back((quantity + 7) / 8);
+          this->tx_buffer_.resize(3 + (quantity + 7) / 8, 0);
+          for (uint16_t i = 0; i < quantity && exception == 0; i++)
+          {
+            bool value;
+            if (!this->read_bit_(function, start + i, value))
+              exception = EXCEPTION_ILLEGAL_DATA_ADDRESS;
+            else if (value)
+              this->tx_buffer_[3 + i / 8] |= 1 << (i % 8);
+          }
+          break;
+        }
+
+        // read holding / input registers
+        case 0x03:
+        case 0x04:
+        {
+          if (quantity < 1 || quantity > 125)
+          {
+            exception = EXCEPTION_ILLEGAL_DATA_VALUE;
+            break;
+          }
+
+          this->tx_buffer_.push_back(quantity * 2);
+          for (uint16_t i = 0; i < quantity && exception == 0; i++)
+          {
+            uint16_t value;
+            if (!this->read_register_(function, start + i, value))
+            {
+              exception = EXCEPTION_ILLEGAL_DATA_ADDRESS;
+              break;
+            }
+            this->tx_buffer_.push_back(value >> 8);
+            this->tx_buffer_.push_back(value & 0xFF);
+          }
+          break;
+        }
+
+        // write single coil
+        case 0x05:
+        {
+          if (quantity != 0xFF00 && quantity != 0x0000)
+          {
+            exception = EXCEPTION_ILLEGAL_DATA_VALUE;
+            break;
+          }
+
+          exception = this->write_coil_(start, quantity == 0xFF00);
+          this->tx_buffer_.insert(this->tx_buffer_.end(), this->rx_buffer_.begin() + 2, this->rx_buffer_.begin() + 6);
+          break;
+        }
+
+        // write single register
+        case 0x06:
+        {
+          exception = this->write_register_(start, quantity);
+          this->tx_buffer_.insert(this->tx_buffer_.end(), this->rx_buffer_.begin() + 2, this->rx_buffer_.begin() + 6);
+          break;
+        }
+
+        // write multiple coils
+        case 0x0F:
+        {
+          if (quantity < 1 || quantity > 1968 || this->rx_buffer_[6] != (quantity + 7) / 8)
+          {
+            exception = EXCEPTION_ILLEGAL_DATA_VALUE;
+            break;
+          }
+
+          for (uint16_t i = 0; i < quantity && exception == 0; i++)
+            exception = this->write_coil_(start + i, (this->rx_buffer_[7 + i / 8] >> (i % 8)) & 1);
+          this->tx_buffer_.insert(this->tx_buffer_.end(), this->rx_buffer_.begin() + 2, this->rx_buffer_.begin() + 6);
+          break;
+        }
+
+        // write multiple registers
+        case 0x10:
+        {
+          if (quantity < 1 || quantity > 123 || this->rx_buffer_[6] != quantity * 2)
+          {
+            exception = EXCEPTION_ILLEGAL_DATA_VALUE;
+            break;
+          }
+
+          for (uint16_t i = 0; i < quantity && exception == 0; i++)
+            exception = this->write_register_(start + i, encode_uint16(this->rx_buffer_[7 + i * 2], this->rx_buffer_[8 + i * 2]));
+          this->tx_buffer_.insert(this->tx_buffer_.end(), this->rx_buffer_.begin() + 2, this->rx_buffer_.begin() + 6);
+          break;
+        }
+
+        default:
+          exception = EXCEPTION_ILLEGAL_FUNCTION;
+          break;
+      }
+
+      // anything that was written before an exception is still sent to the zones
+      if (this->written_devices_.size() > 0)
+        this->lgap_->queue_group_write(this->written_devices_);
+
+      if (broadcast)
+        return;
+
+      if (exception != 0)
+        this->send_exception_(function, exception);
+      else
+        this->send_response_();
+    }
+
+    bool LGAPModbusServer::read_bit_(uint8_t function, uint16_t address, bool &value)
+    {
+      uint8_t zone_number = address / ZONE_BLOCK_SIZE;
+      uint8_t offset = address % ZONE_BLOCK_SIZE;
+      if (address / ZONE_BLOCK_SIZE > 255 || this->lgap_->get_device(zone_number) == nullptr)
+        return false;
+
+      // zones that haven't responded yet read as zero, unmapped values (alarms etc) always read as zero
+      value = false;
+      const ZoneState *zone_state = this->lgap_->get_zone_state(zone_number);
+      if (zone_state == nullptr)
+        return true;
+
+      if (function == 0x01 && offset == COIL_POWER_STATE)
+        value = zone_state->power_state;
+      else if (function == 0x01 && offset == COIL_SWING)
+        value = zone_state->swing;
+      else if (function == 0x02 && offset == DISCRETE_IDU_CONNECTED)
+        value = zone_state->idu_connected;
+      return true;
+    }
+
+    bool LGAPModbusServer::read_register_(uint8_t function, uint16_t address, uint16_t &value)
+    {
+      uint8_t zone_number = address / ZONE_BLOCK_SIZE;
+      uint8_t offset = address % ZONE_BLOCK_SIZE;
+      if (address / ZONE_BLOCK_SIZE > 255 || this->lgap_->get_device(zone_number) == nullptr)
+        return false;
+
+      value = 0;
+      const ZoneState *zone_state = this->lgap_->get_zone_state(zone_number);
+      if (zone_state == nullptr)
+      {
+        if (function == 0x04 && offset == INPUT_STATE_AGE)
+          value = 0xFFFF;
+        return true;
+      }
+
+      if (function == 0x03)
+      {
+        if (offset == HOLDING_MODE)
+          value = zone_state->mode;
+        else if (offset == HOLDING_FAN_SPEED)
+          value = zone_state->fan_speed + 1;
+        else if (offset == HOLDING_TARGET_TEMPERATURE)
+          value = zone_state->target_temperature * 10;
+        return true;
+      }
+
+      // modbus temperatures are in tenths of a degree
+      if (offset == INPUT_ROOM_TEMPERATURE)
+        value = zone_state->room_temperature * 10;
+      else if (offset == INPUT_PIPE_IN_TEMPERATURE)
+        value = zone_state->pipe_in_temperature * 10;
+      else if (offset == INPUT_PIPE_OUT_TEMPERATURE)
+        value = zone_state->pipe_out_temperature * 10;
+      else if (offset == INPUT_STATE_SEQUENCE)
+        value = zone_state->sequence & 0xFFFF;
+      else if (offset == INPUT_STATE_AGE)
+        value = std::min<uint32_t>((millis() - zone_state->last_update_time) / 1000, 0xFFFE);
+      return true;
+    }
+
+    uint8_t LGAPModbusServer::write_coil_(uint16_t address, bool value)
+    {
+      LGAPDevice *device = address / ZONE_BLOCK_SIZE > 255 ? nullptr : this->lgap_->get_device(address / ZONE_BLOCK_SIZE);
+      uint8_t offset = address % ZONE_BLOCK_SIZE;
+      if (device == nullptr || (offset != COIL_POWER_STATE && offset != COIL_SWING))
+        return EXCEPTION_ILLEGAL_DATA_ADDRESS;
+
+      if (!device->request_write(offset == COIL_POWER_STATE ? WRITE_POWER_STATE : WRITE_SWING, value))
+        return EXCEPTION_ILLEGAL_DATA_VALUE;
+
+      if (std::find(this->written_devices_.begin(), this->written_devices_.end(), device) == this->written_devices_.end())
+        this->written_devices_.push_back(device);
+      return 0;
+    }
+
+    uint8_t LGAPModbusServer::write_register_(uint16_t address, uint16_t value)
+    {
+      LGAPDevice *device = address / ZONE_BLOCK_SIZE > 255 ? nullptr : this->lgap_->get_device(address / ZONE_BLOCK_SIZE);
+      uint8_t offset = address % ZONE_BLOCK_SIZE;
+      if (device == nullptr)
+        return EXCEPTION_ILLEGAL_DATA_ADDRESS;
+
+      bool accepted;
+      if (offset == HOLDING_MODE)
+      {
+        accepted = value <= 4 && device->request_write(WRITE_MODE, value);
+      }
+      else if (offset == HOLDING_FAN_SPEED)
+      {
+        // 1: low, 2: medium, 3: high, 4: auto. auto isn't supported by LGAP so it maps to low like the climate entity
+        accepted = value >= 1 && value <= 4 && device->request_write(WRITE_FAN_SPEED, value == 4 ? 0 : value - 1);
+      }
+      else if (offset == HOLDING_TARGET_TEMPERATURE)
+      {
+        // the request only has 4 bits for target - 15, so 30 is the highest temperature that can be sent
+        uint16_t temperature = (value + 5) / 10;
+        accepted = temperature >= 16 && temperature <= 30 && device->request_write(WRITE_TARGET_TEMPERATURE, temperature);
+      }
+      else
+      {
+        return EXCEPTION_ILLEGAL_DATA_ADDRESS;
+      }
+
+      if (!accepted)
+        return EXCEPTION_ILLEGAL_DATA_VALUE;
+
+      if (std::find(this->written_devices_.begin(), this->written_devices_.end(), device) == this->written_devices_.end())
+        this->written_devices_.push_back(device);
+      return 0;
+    }
+
+    void LGAPModbusServer::send_exception_(uint8_t function, uint8_t exception)
+    {
+      this->tx_buffer_.clear();
+      this->tx_buffer_.push_back(this->address_);
+      this->tx_buffer_.push_back(function | 0x80);
+      this->tx_buffer_.push_back(exception);
+      this->send_response_();
+    }
+
+    void LGAPModbusServer::send_response_()
+    {
+      uint16_t crc = calculate_crc(this->tx_buffer_.data(), this->tx_buffer_.size());
+      this->tx_buffer_.push_back(crc & 0xFF);
+      this->tx_buffer_.push_back(crc >> 8);
+
+      if (this->flow_control_pin_ != nullptr)
+        this->flow_control_pin_->digital_write(true);
+
+      this->write_array(this->tx_buffer_.data(), this->tx_buffer_.size());
+      this->flush();
+
+      if (this->flow_control_pin_ != nullptr)
+        this->flow_control_pin_->digital_write(false);
+    }
+
+  } // namespace lgap
+} // namespace esphome
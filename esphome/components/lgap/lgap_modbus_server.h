@@ -0,0 +1,58 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/uart/uart.h"
+#include <vector>
+#include "lgap.h"
+
+namespace esphome
+{
+  namespace lgap
+  {
+    class LGAP;
+    class LGAPDevice;
+
+    // answers Modbus RTU requests using the PMBUSB00A register layout (see protocol.md)
+    // reads come straight from the LGAP zone state cache, writes are forwarded to the LGAP bus as a group write
+    class LGAPModbusServer : public uart::UARTDevice, public Component
+    {
+      public:
+        const char *const TAG = "lgap.modbus_server";
+
+        void setup() override;
+        void loop() override;
+        void dump_config() override;
+        float get_setup_priority() const override;
+
+        // uart::UARTDevice already uses parent_ for the uart
+        void set_parent(LGAP *parent) { this->lgap_ = parent; }
+        void set_address(uint8_t address) { this->address_ = address; }
+        void set_flow_control_pin(GPIOPin *flow_control_pin) { this->flow_control_pin_ = flow_control_pin; }
+
+      protected:
+        size_t expected_frame_length_();
+        void process_frame_();
+        void send_response_();
+        void send_exception_(uint8_t function, uint8_t exception);
+
+        bool read_bit_(uint8_t function, uint16_t address, bool &value);
+        bool read_register_(uint8_t function, uint16_t address, uint16_t &value);
+        uint8_t write_coil_(uint16_t address, bool value);
+        uint8_t write_register_(uint16_t address, uint16_t value);
+
+        LGAP *lgap_{nullptr};
+        GPIOPin *flow_control_pin_{nullptr};
+        uint8_t address_{1};
+
+        // 3.5 character times in microseconds, derived from the baud rate in setup()
+        uint32_t frame_gap_{0};
+        uint32_t last_byte_time_{0};
+        std::vector<uint8_t> rx_buffer_;
+        std::vector<uint8_t> tx_buffer_;
+
+        // zones written by the frame being processed, sent to LGAP as one group write
+        std::vector<LGAPDevice *> written_devices_{};
+    };
+
+  } // namespace lgap
+} // namespace esphome
@@ -0,0 +1,37 @@
+#include "lgap_trace.h"
+
+namespace esphome
+{
+  namespace lgap
+  {
+    const char *trace_event_type_to_string(TraceEventType type)
+    {
+      switch (type)
+      {
+        case TRACE_STATE:
+          return "STATE";
+        case TRACE_TX_REQUEST:
+          return "TX_REQUEST";
+        case TRACE_RX_REQUEST:
+          return "RX_REQUEST";
+        case TRACE_RX_BYTE:
+          return "RX_BYTE";
+        case TRACE_RX_RESPONSE:
+          return "RX_RESPONSE";
+        case TRACE_RX_INVALID_START:
+          return "RX_INVALID_START";
+        case TRACE_CHECKSUM_FAIL:
+          return "CHECKSUM_FAIL";
+        case TRACE_TIMEOUT:
+          return "TIMEOUT";
+        case TRACE_ZONE_REQUEST:
+          return "ZONE_REQUEST";
+        case TRACE_ZONE_DECODE:
+          return "ZONE_DECODE";
+        default:
+          return "UNKNOWN";
+      }
+    }
+
+  } // namespace lgap
+} // namespace esphome
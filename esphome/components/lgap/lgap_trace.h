@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef USE_LGAP_TRACE
+#include <atomic>
+#include <memory>
+#include "esphome/core/hal.h"
+#endif
+
+namespace esphome
+{
+  namespace lgap
+  {
+    enum TraceEventType : uint8_t
+    {
+      TRACE_STATE,          // arg0: new state
+      TRACE_TX_REQUEST,     // arg0: request id, arg1: 1 if write request
+      TRACE_RX_REQUEST,     // request from another master in passive mode, arg0: request id, arg1: 1 if write request
+      TRACE_RX_BYTE,        // arg0: byte, arg1: rx buffer size before the byte
+      TRACE_RX_RESPONSE,    // arg0: response id, arg1: 1 if matched to the last request
+      TRACE_RX_INVALID_START, // arg0: byte
+      TRACE_CHECKSUM_FAIL,  // arg0: calculated checksum, arg1: received checksum
+      TRACE_TIMEOUT,        // zone only
+      TRACE_ZONE_REQUEST,   // arg0: 1 if write request
+      TRACE_ZONE_DECODE,    // arg0: room temperature, arg1: 1 if state was published
+    };
+
+    // fixed size binary trace record, 8 bytes so the ring stays small
+    struct TraceEvent
+    {
+      uint32_t timestamp;
+      TraceEventType type;
+      uint8_t zone;
+      uint8_t arg0;
+      uint8_t arg1;
+    };
+
+    const char *trace_event_type_to_string(TraceEventType type);
+
+#ifdef USE_LGAP_TRACE
+    // single producer ring buffer. the producer (LGAP::loop) never blocks and
+    // overwrites the oldest events, readers use head_ to detect overwritten slots
+    class TraceBuffer
+    {
+      public:
+        void init(uint16_t size)
+        {
+          // size is validated to be a power of two in the yaml schema
+          this->events_.reset(new TraceEvent[size]);
+          this->mask_ = size - 1;
+        }
+
+        uint16_t size() const { return this->mask_ + 1; }
+
+        inline void record(TraceEventType type, uint8_t zone, uint8_t arg0, uint8_t arg1)
+        {
+          if (this->events_ == nullptr)
+            return;
+
+          uint32_t head = this->head_.load(std::memory_order_relaxed);
+          TraceEvent &event = this->events_[head & this->mask_];
+          event.timestamp = micros();
+          event.type = type;
+          event.zone = zone;
+          event.arg0 = arg0;
+          event.arg1 = arg1;
+          this->head_.store(head + 1, std::memory_order_release);
+        }
+
+        // copies the event with sequence number `index` into `event`. returns false if
+        // the slot has been (or is being) overwritten since it was recorded
+        bool read(uint32_t index, TraceEvent &event) const
+        {
+          event = this->events_[index & this->mask_];
+          return (this->head_.load(std::memory_order_acquire) - index) <= this->mask_;
+        }
+
+        uint32_t head() const { return this->head_.load(std::memory_order_acquire); }
+
+      protected:
+        std::unique_ptr<TraceEvent[]> events_{nullptr};
+        uint16_t mask_{0};
+        std::atomic<uint32_t> head_{0};
+    };
+
+#define LGAP_TRACE(lgap, type, zone, arg0, arg1) (lgap)->record_trace((type), (zone), (arg0), (arg1))
+#else
+#define LGAP_TRACE(lgap, type, zone, arg0, arg1)
+#endif
+
+  } // namespace lgap
+} // namespace esphome